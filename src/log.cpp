@@ -0,0 +1,3 @@
+#include "log.hh"
+
+uint32_t log::level = 2; // errors and info
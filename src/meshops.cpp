@@ -0,0 +1,373 @@
+#include "meshops.hh"
+#include "log.hh"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+
+uint32_t meshops::threads = 0;
+
+/*
+    run body(begin, end) over [0, n) split across meshops::threads threads.
+    small jobs run on the calling thread since spawning costs more than the work
+*/
+template<typename F>
+static void parallel_for(uint32_t n, F body) {
+    const uint32_t min_chunk = 4096;
+    uint32_t threads = meshops::threads;
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    threads = std::min(threads, (n + min_chunk - 1) / min_chunk);
+    if (threads <= 1) {
+        body(0, n);
+        return;
+    }
+    std::vector<std::thread> pool;
+    const uint32_t chunk = (n + threads - 1) / threads;
+    for (uint32_t begin = chunk; begin < n; begin += chunk)
+        pool.emplace_back(body, begin, std::min(begin + chunk, n));
+    body(0, std::min(chunk, n));
+    for (auto& t : pool)
+        t.join();
+}
+
+// hash a grid cell into one key. collisions only cost extra distance checks
+static uint64_t cell_key(int64_t x, int64_t y, int64_t z) {
+    return (uint64_t(x) * 73856093ULL) ^
+           (uint64_t(y) * 19349663ULL) ^
+           (uint64_t(z) * 83492791ULL);
+}
+
+/*
+    grid cell of one coordinate. clamped well inside int64_t so the cast is
+    defined for any finite input and the +-1 neighbour offsets cannot overflow
+*/
+static int64_t cell_of(float x, double inv) {
+    const double limit = 4.0e18;
+    const double c = std::floor(double(x) * inv);
+    if (!(c > -limit))
+        return int64_t(-limit);
+    if (!(c < limit))
+        return int64_t(limit);
+    return int64_t(c);
+}
+
+mesh meshops::from_arrays(const float vert[], uint32_t vert_size,
+                          const uint32_t indices[], uint32_t index_size,
+                          uint32_t stride) {
+    mesh m(stride);
+    m.vert.assign(vert, vert + vert_size);
+    m.indices.assign(indices, indices + index_size);
+    return m;
+}
+
+void meshops::transform(mesh& m, const float xform[16]) {
+    if (m.stride < 3) {
+        log::error("meshops::transform: vertex stride must hold a position");
+        return;
+    }
+    float* v = m.vert.data();
+    const uint32_t stride = m.stride;
+    parallel_for(m.num_vertices(), [=](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            float* p = v + i * stride;
+            const float x = p[0], y = p[1], z = p[2];
+            p[0] = xform[0] * x + xform[4] * y + xform[8]  * z + xform[12];
+            p[1] = xform[1] * x + xform[5] * y + xform[9]  * z + xform[13];
+            p[2] = xform[2] * x + xform[6] * y + xform[10] * z + xform[14];
+        }
+    });
+}
+
+void meshops::merge(mesh& dst, const mesh& src) {
+    if (dst.stride != src.stride) {
+        log::error("meshops::merge: vertex strides do not match");
+        return;
+    }
+    if (&dst == &src) {
+        // growing dst would invalidate the ranges being read from src
+        const mesh copy = src;
+        merge(dst, copy);
+        return;
+    }
+    const uint32_t base = dst.num_vertices();
+    dst.vert.insert(dst.vert.end(), src.vert.begin(), src.vert.end());
+    const size_t start = dst.indices.size();
+    dst.indices.resize(start + src.indices.size());
+    for (size_t i = 0; i < src.indices.size(); i++)
+        dst.indices[start + i] = src.indices[i] + base;
+}
+
+void meshops::merge(mesh& dst, const mesh& src, const float xform[16]) {
+    mesh moved = src;
+    transform(moved, xform);
+    merge(dst, moved);
+}
+
+/*
+    weld works in 4 passes:
+    1. (parallel) bucket every vertex into a grid of cell size eps
+    2. sort vertex ids by bucket so each bucket is a contiguous, ordered range
+    3. (parallel) each vertex searches the 27 surrounding cells for the
+       lowest numbered vertex that matches it
+    4. chains are collapsed in order, survivors are renumbered and copied out,
+       and (parallel) the index buffer is rewritten
+*/
+uint32_t meshops::weld(mesh& m, float eps) {
+    if (!(eps > 0)) {
+        log::error("meshops::weld: eps must be positive");
+        return 0;
+    }
+    if (m.stride < 3) {
+        log::error("meshops::weld: vertex stride must hold a position");
+        return 0;
+    }
+    if (m.indices.size() % 3 != 0) {
+        log::error("meshops::weld: indices are not a triangle list");
+        return 0;
+    }
+    if (m.vert.size() % m.stride != 0) {
+        log::error("meshops::weld: vertex data is not a whole number of vertices");
+        return 0;
+    }
+    const uint32_t n = m.num_vertices();
+    const uint32_t stride = m.stride;
+    for (uint32_t i : m.indices)
+        if (i >= n) {
+            log::error("meshops::weld: index out of range");
+            return 0;
+        }
+    if (n == 0)
+        return 0;
+    const double inv = 1.0 / eps;
+    const float* v = m.vert.data();
+
+    std::vector<int64_t> cells(size_t(n) * 3);
+    std::vector<uint64_t> keys(n);
+    parallel_for(n, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            for (uint32_t k = 0; k < 3; k++)
+                cells[i * 3 + k] = cell_of(v[i * stride + k], inv);
+            keys[i] = cell_key(cells[i * 3], cells[i * 3 + 1], cells[i * 3 + 2]);
+        }
+    });
+
+    std::vector<uint32_t> order(n);
+    for (uint32_t i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return keys[a] != keys[b] ? keys[a] < keys[b] : a < b;
+    });
+    // bucket key -> [first, last) into order
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> buckets;
+    buckets.reserve(n);
+    for (uint32_t i = 0; i < n; ) {
+        uint32_t j = i + 1;
+        while (j < n && keys[order[j]] == keys[order[i]])
+            j++;
+        buckets[keys[order[i]]] = {i, j};
+        i = j;
+    }
+
+    // every component within eps, so vertices on a UV seam stay apart
+    auto same = [&](uint32_t a, uint32_t b) {
+        for (uint32_t k = 0; k < stride; k++)
+            if (std::fabs(v[a * stride + k] - v[b * stride + k]) > eps)
+                return false;
+        return true;
+    };
+
+    std::vector<uint32_t> remap(n);
+    parallel_for(n, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t rep = i;
+            const int64_t* c = &cells[size_t(i) * 3];
+            for (int64_t dx = -1; dx <= 1; dx++)
+                for (int64_t dy = -1; dy <= 1; dy++)
+                    for (int64_t dz = -1; dz <= 1; dz++) {
+                        auto it = buckets.find(cell_key(c[0] + dx, c[1] + dy, c[2] + dz));
+                        if (it == buckets.end())
+                            continue;
+                        // ids are ascending within a bucket, stop once past rep
+                        for (uint32_t b = it->second.first; b < it->second.second; b++) {
+                            const uint32_t j = order[b];
+                            if (j >= rep)
+                                break;
+                            if (same(i, j))
+                                rep = j;
+                        }
+                    }
+            remap[i] = rep;
+        }
+    });
+
+    // remap[i] <= i, so one forward pass resolves chains to their root.
+    // the root may be more than eps from the end of a chain
+    std::vector<uint32_t> newidx(n);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        remap[i] = remap[remap[i]];
+        newidx[i] = remap[i] == i ? count++ : newidx[remap[i]];
+    }
+    if (count == n)
+        return 0;
+
+    std::vector<float> out(size_t(count) * stride);
+    parallel_for(n, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+            if (remap[i] == i)
+                std::copy(v + i * stride, v + (i + 1) * stride, &out[newidx[i] * stride]);
+    });
+    m.vert.swap(out);
+
+    uint32_t* idx = m.indices.data();
+    parallel_for(m.indices.size(), [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+            idx[i] = newidx[idx[i]];
+    });
+
+    // drop triangles that collapsed to a line or point
+    uint32_t c = 0;
+    for (uint32_t t = 0; t < m.indices.size(); t += 3) {
+        const uint32_t a = idx[t], b = idx[t + 1], d = idx[t + 2];
+        if (a == b || b == d || a == d)
+            continue;
+        idx[c++] = a;
+        idx[c++] = b;
+        idx[c++] = d;
+    }
+    m.indices.resize(c);
+    return n - count;
+}
+
+shape meshops::to_shape(const mesh& m) {
+    return shape(m.vert.data(), m.vert.size(), m.indices.data(), m.indices.size());
+}
+
+/*
+    unit sphere (r=1) with lon_res points around the equator and
+    2*lat_res-1 rings between the poles. Each ring repeats its first point
+    at u=1 so the texture wraps, and the poles are closed with fans
+*/
+mesh meshops::mesh_sphere(uint32_t lat_res, uint32_t lon_res) {
+    const uint32_t yres = 2*lat_res-1;
+    const uint32_t xres = lon_res + 1; // includes +1 for wrapping back to the start
+    const double dlon = 2.0*PI / lon_res, dlat = PI / (2*lat_res);
+    mesh m(5);
+    m.vert.reserve((yres*xres + 2) * 5);
+    m.indices.reserve(((yres-1)*lon_res*2 + 2*lon_res) * 3);
+
+    double lat = -PI/2 + dlat; // latitude in radians
+    for (uint32_t j = 0; j < yres; j++, lat += dlat) {
+        const double rcircle = cos(lat); // size of the circle at this latitude
+        const double z = sin(lat); // height of each circle
+        for (uint32_t i = 0; i < xres; i++) {
+            const double t = i * dlon;
+            m.vert.insert(m.vert.end(), {
+                float(rcircle * cos(t)), float(rcircle * sin(t)), float(z),
+                float(double(i) / lon_res), float((lat + PI / 2.0) / PI)});
+        }
+    }
+    const uint32_t south = yres*xres, north = south + 1;
+    m.vert.insert(m.vert.end(), {0, 0, -1, 0.5f, 0});
+    m.vert.insert(m.vert.end(), {0, 0, +1, 0.5f, 1});
+
+    for (uint32_t j = 0; j < yres-1; j++) {
+        for (uint32_t i = 0; i < lon_res; i++) {
+            const uint32_t a = j*xres + i, b = a + 1, c = a + xres, d = c + 1;
+            m.indices.insert(m.indices.end(), {a, b, c,  c, b, d});
+        }
+    }
+    const uint32_t top = (yres-1)*xres;
+    for (uint32_t i = 0; i < lon_res; i++) {
+        m.indices.insert(m.indices.end(), {south, i + 1, i});
+        m.indices.insert(m.indices.end(), {top + i, top + i + 1, north});
+    }
+    return m;
+}
+
+/*
+    unit cylinder (r=1, h=1) centered on the origin with res facets around
+    the circumference. Each cap is a center plus res+1 rim points, the last
+    duplicating the first
+*/
+mesh meshops::mesh_cylinder(uint32_t res) {
+    const float radius = 1.0f;
+    const float height = 1.0f;
+    const float angleStep = 2.0f * PI / res;
+    mesh m(5);
+    m.vert.reserve(((res + 1) * 2 + 2) * 5);
+    m.indices.reserve(res * 12);
+
+    // top center (index 0), then top rim (indices 1 to res+1)
+    // bottom center (index res+2), then bottom rim (indices res+3 to 2*res+3)
+    for (float y : {height / 2.0f, -height / 2.0f}) {
+        m.vert.insert(m.vert.end(), {0.0f, y, 0.0f, 0.5f, 0.5f});
+        for (uint32_t i = 0; i <= res; i++) {
+            const float angle = i * angleStep;
+            m.vert.insert(m.vert.end(), {
+                radius * cosf(angle), y, radius * sinf(angle),
+                (cosf(angle) + 1.0f) / 2.0f, (sinf(angle) + 1.0f) / 2.0f});
+        }
+    }
+
+    const uint32_t bottomCenterIndex = res + 2;
+    const uint32_t bottomStartIndex = res + 3;
+    // top face: triangle fan around index 0
+    for (uint32_t i = 0; i < res; i++)
+        m.indices.insert(m.indices.end(), {0, 1 + i, 1 + i + 1});
+    // bottom face: winding is reversed so the face normal points downward
+    for (uint32_t i = 0; i < res; i++)
+        m.indices.insert(m.indices.end(),
+            {bottomCenterIndex, bottomStartIndex + i + 1, bottomStartIndex + i});
+    // side faces: each segment forms a quad (2 triangles)
+    for (uint32_t i = 0; i < res; i++) {
+        const uint32_t top1 = 1 + i, top2 = 1 + i + 1;
+        const uint32_t bot1 = bottomStartIndex + i, bot2 = bottomStartIndex + i + 1;
+        m.indices.insert(m.indices.end(), {top1, top2, bot1,  bot1, top2, bot2});
+    }
+    return m;
+}
+
+/*
+    torus with a major radius of 1.0, broken into ring_res sections
+    around the torus, with the tube radius of radius broken into
+    tube_res sections. Both seams are duplicated so u and v reach 1
+*/
+mesh meshops::mesh_torus(float radius, uint32_t ring_res, uint32_t tube_res) {
+    // the angle around the torus
+    const double theta_res = 2*PI / ring_res;
+    // the angle around the tube
+    const double phi_res = 2*PI / tube_res;
+    const uint32_t w = tube_res + 1;
+    mesh m(5);
+    m.vert.reserve((ring_res + 1) * w * 5);
+    m.indices.reserve(ring_res * tube_res * 6);
+
+    for (uint32_t i = 0; i <= ring_res; i++) {
+        for (uint32_t j = 0; j <= tube_res; j++) {
+            const double theta = i * theta_res;
+            const double phi = j * phi_res;
+            m.vert.insert(m.vert.end(), {
+                float((radius + cos(phi)) * cos(theta)),
+                float((radius + cos(phi)) * sin(theta)),
+                float(sin(phi)),
+                float(double(i) / ring_res), float(double(j) / tube_res)});
+        }
+    }
+    /*
+    * i,j ---- (i+1, j)
+    * |
+    * |
+    * (i, j+1) ---- (i+1, j+1)
+    */
+    for (uint32_t i = 0; i < ring_res; i++) {
+        for (uint32_t j = 0; j < tube_res; j++) {
+            const uint32_t a = i * w + j, b = (i + 1) * w + j;
+            m.indices.insert(m.indices.end(), {a, b, a + 1,  b, b + 1, a + 1});
+        }
+    }
+    return m;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "shape.hh"
+
+/*
+    CPU-side mesh used to compose generated primitives before uploading.
+    Each vertex is stride floats, position (x,y,z) first, followed by any
+    other attributes (u,v for sphere/cylinder/torus, r,g,b for circle).
+    indices form a triangle list, strips must be converted before welding.
+*/
+struct mesh {
+    uint32_t stride;
+    std::vector<float> vert;
+    std::vector<uint32_t> indices;
+
+    explicit mesh(uint32_t stride = 5) : stride(stride) {}
+    uint32_t num_vertices() const { return stride ? vert.size() / stride : 0; }
+};
+
+/**
+* meshops class
+* static methods to transform, merge and weld meshes so that composite
+* objects (capsules, tubes) share their seam vertices
+*/
+class meshops {
+public:
+    // worker threads for the parallel passes, 0 uses hardware_concurrency
+    static uint32_t threads;
+
+    // copy vert/indices (same layout as the shape constructor) into a mesh
+    static mesh from_arrays(const float vert[], uint32_t vert_size,
+                            const uint32_t indices[], uint32_t index_size,
+                            uint32_t stride = 5);
+
+    // multiply every position by a 4x4 column-major matrix (OpenGL order)
+    // stride must be at least 3
+    static void transform(mesh& m, const float xform[16]);
+
+    // append src to dst, offsetting the indices of src. strides must match
+    // and dst may be src, merge(m, m) doubles m
+    static void merge(mesh& dst, const mesh& src);
+    static void merge(mesh& dst, const mesh& src, const float xform[16]);
+
+    /*
+        merge vertices whose positions lie within eps of each other and whose
+        remaining attributes also match within eps, so UV seams are kept as
+        separate vertices. Welding is transitive: if a matches b and b matches
+        c, all three become the lowest numbered one even when a and c are
+        further than eps apart, so a run of close vertices can drift by
+        several eps. Triangles that collapse are dropped and the vertex and
+        index buffers are rebuilt compactly.
+        eps must be > 0, stride at least 3, vert a whole number of vertices
+        and indices a whole number of triangles that all refer to existing
+        vertices, otherwise an error is logged and m is left untouched.
+        returns the number of vertices removed
+    */
+    static uint32_t weld(mesh& m, float eps = 1e-5f);
+
+    static shape to_shape(const mesh& m);
+
+    /*
+        CPU-side builders behind shape::gen_sphere, gen_cylinder and gen_torus,
+        so generated primitives can be transformed, merged and welded before
+        upload. All emit x,y,z,u,v triangle lists with the UV seam duplicated
+    */
+    static mesh mesh_sphere(uint32_t lat_res, uint32_t lon_res);
+    static mesh mesh_cylinder(uint32_t ring_res);
+    static mesh mesh_torus(float tube_radius, uint32_t ring_res, uint32_t tube_res);
+};
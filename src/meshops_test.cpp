@@ -0,0 +1,152 @@
+#include "log.hh"
+#include "meshops.hh"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+/*
+    checks for meshops transform, merge and weld. Only the CPU side is
+    exercised, so the GL upload in the shape constructor is stubbed out
+*/
+shape::shape(const float vert[], const uint32_t vert_size,
+            const uint32_t indices[], const uint32_t index_size)
+    : vao(0), vbo(0), ibo(0), indexSize(index_size) {}
+
+static const float* vertex(const mesh& m, uint32_t i) {
+    return &m.vert[i * m.stride];
+}
+
+/*
+    every index slot must still point at the same attributes after welding.
+    welding is transitive, so allow 2*eps for a chain of two matches
+*/
+static void check_remap(const mesh& before, const mesh& after, float eps) {
+    assert(before.indices.size() == after.indices.size());
+    for (size_t k = 0; k < after.indices.size(); k++) {
+        assert(after.indices[k] < after.num_vertices());
+        const float* a = vertex(before, before.indices[k]);
+        const float* b = vertex(after, after.indices[k]);
+        for (uint32_t c = 0; c < before.stride; c++)
+            assert(std::fabs(a[c] - b[c]) <= 2 * eps);
+    }
+}
+
+/*
+    stack two unit cylinders into a tube of height 2. The top cap of the
+    first and the bottom cap of the second coincide, as do the rim seam
+    duplicates, so each cylinder keeps 2*res+2 vertices and the shared
+    cap (center + res rim points) is counted once
+*/
+static void test_stacked_cylinders() {
+    const uint32_t res = 16;
+    const float up[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,1,0,1};
+    mesh m = meshops::mesh_cylinder(res);
+    assert(m.num_vertices() == 2 * res + 4);
+    meshops::merge(m, meshops::mesh_cylinder(res), up);
+    assert(m.num_vertices() == 4 * res + 8);
+    assert(vertex(m, 2 * res + 4)[1] == 1.5f); // second top center moved up
+
+    const mesh before = m;
+    const uint32_t removed = meshops::weld(m);
+    assert(m.num_vertices() == 3 * res + 3);
+    assert(removed == res + 5);
+    check_remap(before, m, 1e-5f);
+}
+
+// the sphere seam has u=0 and u=1 at the same position, those must survive
+static void test_sphere_seam() {
+    const uint32_t lat = 64, lon = 128; // large enough to split across threads
+    mesh m = meshops::mesh_sphere(lat, lon);
+    const uint32_t n = m.num_vertices();
+    assert(n == (2 * lat - 1) * (lon + 1) + 2);
+    assert(m.indices.size() % 3 == 0);
+    assert(meshops::weld(m) == 0);
+    assert(m.num_vertices() == n);
+
+    // two copies of the same sphere collapse onto one
+    meshops::merge(m, meshops::mesh_sphere(lat, lon));
+    const mesh before = m;
+    assert(meshops::weld(m) == n);
+    assert(m.num_vertices() == n);
+    check_remap(before, m, 1e-5f);
+}
+
+// merging a mesh into itself doubles it, then welding undoes that
+static void test_self_merge() {
+    const uint32_t res = 64;
+    mesh m = meshops::mesh_cylinder(res);
+    const mesh once = m;
+    meshops::merge(m, m);
+    assert(m.num_vertices() == 2 * once.num_vertices());
+    assert(m.indices.size() == 2 * once.indices.size());
+    for (size_t k = 0; k < once.indices.size(); k++) {
+        assert(m.indices[k] == once.indices[k]);
+        assert(m.indices[once.indices.size() + k] == once.indices[k] + once.num_vertices());
+    }
+    for (size_t k = 0; k < once.vert.size(); k++)
+        assert(m.vert[once.vert.size() + k] == once.vert[k]);
+    // each copy welds its rim seam, and the second copy folds onto the first
+    assert(meshops::weld(m) == once.num_vertices() + 2);
+}
+
+// a chain of matches welds end points that are further than eps apart
+static void test_transitive() {
+    const float eps = 1e-3f;
+    mesh m(5);
+    m.vert = {0,0,0,0,0,  0.0008f,0,0,0,0,  0.0016f,0,0,0,0,  1,0,0,0,0};
+    m.indices = {0, 3, 1,  1, 3, 2};
+    assert(meshops::weld(m, eps) == 2);
+    assert(m.num_vertices() == 2);
+    assert(m.vert[0] == 0 && m.vert[5] == 1);
+    assert(m.indices.empty()); // both triangles collapsed onto an edge
+}
+
+static void test_bad_input() {
+    mesh strip(5);
+    strip.vert = {0,0,0,0,0, 1,0,0,0,0, 0,1,0,0,0, 1,1,0,0,0};
+    strip.indices = {0, 1, 2, 3};
+    assert(meshops::weld(strip) == 0);
+    assert(strip.indices.size() == 4 && strip.num_vertices() == 4);
+
+    mesh tri(5);
+    tri.vert = {0,0,0,0,0, 0,0,0,0,0, 1,0,0,0,0};
+    tri.indices = {0, 1, 2};
+    assert(meshops::weld(tri, 0.0f) == 0);
+    assert(meshops::weld(tri, -1.0f) == 0);
+    assert(tri.num_vertices() == 3);
+
+    // out of range index, with a duplicate so the remap would run
+    mesh range(5);
+    range.vert = {0,0,0,0,0, 0,0,0,0,0, 1,0,0,0,0};
+    range.indices = {0, 1, 7};
+    assert(meshops::weld(range) == 0);
+    assert(range.num_vertices() == 3 && range.indices[2] == 7);
+
+    // trailing floats that do not make up a whole vertex
+    mesh ragged(5);
+    ragged.vert = {0,0,0,0,0, 0,0,0,0,0, 1,0,0,0,0, 9,9};
+    ragged.indices = {0, 1, 2};
+    assert(meshops::weld(ragged) == 0);
+    assert(ragged.vert.size() == 17);
+
+    // far from the origin the grid cells must not overflow
+    mesh far(5);
+    far.vert = {30000,0,0,0,0, 30000,0,0,0,0, -30000,0,0,0,0};
+    far.indices = {0, 1, 2};
+    assert(meshops::weld(far) == 1);
+    assert(far.indices.empty()); // the triangle collapsed
+}
+
+int main() {
+    test_stacked_cylinders();
+    test_sphere_seam();
+    // force the threaded path even on a single core machine
+    meshops::threads = 4;
+    test_sphere_seam();
+    meshops::threads = 0;
+    test_self_merge();
+    test_transitive();
+    test_bad_input();
+    std::cout << "meshops_test passed" << std::endl;
+    return 0;
+}
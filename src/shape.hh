@@ -29,7 +29,7 @@ public:
     static shape gen_circle(uint32_t circle_res); // filled circle
     static shape gen_rhombicuboctahedron();
 
-    shape() : vao(0), vbo(0), ibo(0) {}
+    shape() : vao(0), vbo(0), ibo(0), indexSize(0) {}
     shape(const float vert[], const uint32_t vert_size,
             const uint32_t indices[], const uint32_t index_size);
 // each render method should have an associated precomputed shader program